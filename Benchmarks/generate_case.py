@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+"""Write a synthetic two dimensional interFoam case with a known interface.
+
+The domain is [0,length] x [0,depth] and one cell thick. The free surface is
+the travelling wave
+
+    eta(x,t) = level + amp*sin(2*pi*(x/length - t/period))
+
+alpha.water holds the exact volume fraction of water in each cell and p_rgh
+is rho*g*eta of the cell column, so both the interface height and the data
+on it are known at every point. The case is written in ascii, either
+reconstructed or decomposed into vertical strips with processor patches.
+"""
+import argparse
+import math
+import os
+
+LENGTH = 1000.0
+DEPTH = 400.0
+LEVEL = 200.0
+AMP = 20.0
+PERIOD = 10.0
+THICKNESS = 10.0
+RHOG = 1000.0*9.81
+
+
+def eta(x, t):
+    """analytic interface height at x and time t"""
+    return LEVEL + AMP*math.sin(2*math.pi*(x/LENGTH - t/PERIOD))
+
+
+def header(cls, obj, location=None):
+    lines = ["FoamFile", "{", "    version     2.0;", "    format      ascii;",
+             "    class       %s;" % cls]
+    if location is not None:
+        lines.append('    location    "%s";' % location)
+    lines += ["    object      %s;" % obj, "}", ""]
+    return "\n".join(lines) + "\n"
+
+
+def write_list(f, items, fmt):
+    f.write("%d\n(\n" % len(items))
+    for item in items:
+        f.write(fmt(item))
+        f.write("\n")
+    f.write(")\n")
+
+
+class Strip:
+    """columns [i0,i1) of the nx x ny mesh, owned by processor proc of nprocs
+    (proc is None for a reconstructed case)"""
+
+    def __init__(self, nx, ny, i0, i1, proc, nprocs):
+        self.nx, self.ny = nx, ny
+        self.i0, self.i1 = i0, i1
+        self.proc, self.nprocs = proc, nprocs
+        self.dx = LENGTH/nx
+        self.dy = DEPTH/ny
+        self.ni = i1 - i0
+
+    def point(self, i, j, k):
+        """local id of the point at global column i, row j, layer k"""
+        return (i - self.i0) + (self.ni + 1)*(j + (self.ny + 1)*k)
+
+    def cell(self, i, j):
+        return (i - self.i0) + self.ni*j
+
+    def cell_centre(self, i, j):
+        return (i + 0.5)*self.dx, (j + 0.5)*self.dy
+
+    def xface(self, i, j, outward_plus):
+        """face at x = i*dx of row j, normal along +x or -x"""
+        p = self.point
+        if outward_plus:
+            return (p(i, j, 0), p(i, j + 1, 0), p(i, j + 1, 1), p(i, j, 1))
+        return (p(i, j, 0), p(i, j, 1), p(i, j + 1, 1), p(i, j + 1, 0))
+
+    def yface(self, i, j, outward_plus):
+        """face at y = j*dy of column i, normal along +y or -y"""
+        p = self.point
+        if outward_plus:
+            return (p(i, j, 0), p(i, j, 1), p(i + 1, j, 1), p(i + 1, j, 0))
+        return (p(i, j, 0), p(i + 1, j, 0), p(i + 1, j, 1), p(i, j, 1))
+
+    def patches(self):
+        """(name, type, [(face, owner cell)], neighbour processor) for each
+        boundary patch, in the order they are written"""
+        left, right, bottom, top, sides = [], [], [], [], []
+        for j in range(self.ny):
+            if self.i0 == 0:
+                left.append((self.xface(0, j, False), self.cell(0, j)))
+            if self.i1 == self.nx:
+                right.append((self.xface(self.nx, j, True),
+                              self.cell(self.nx - 1, j)))
+        for i in range(self.i0, self.i1):
+            bottom.append((self.yface(i, 0, False), self.cell(i, 0)))
+            top.append((self.yface(i, self.ny, True), self.cell(i, self.ny - 1)))
+        p = self.point
+        for j in range(self.ny):
+            for i in range(self.i0, self.i1):
+                c = self.cell(i, j)
+                sides.append(((p(i, j, 0), p(i, j + 1, 0), p(i + 1, j + 1, 0),
+                               p(i + 1, j, 0)), c))
+                sides.append(((p(i, j, 1), p(i + 1, j, 1), p(i + 1, j + 1, 1),
+                               p(i, j + 1, 1)), c))
+        result = [("left", "patch", left, None), ("right", "patch", right, None),
+                  ("bottom", "wall", bottom, None), ("atmosphere", "patch", top, None),
+                  ("frontAndBack", "empty", sides, None)]
+        if self.proc is not None:
+            if self.proc > 0:
+                faces = [(self.xface(self.i0, j, False), self.cell(self.i0, j))
+                         for j in range(self.ny)]
+                result.append(("procBoundary%dto%d" % (self.proc, self.proc - 1),
+                               "processor", faces, self.proc - 1))
+            if self.proc < self.nprocs - 1:
+                faces = [(self.xface(self.i1, j, True), self.cell(self.i1 - 1, j))
+                         for j in range(self.ny)]
+                result.append(("procBoundary%dto%d" % (self.proc, self.proc + 1),
+                               "processor", faces, self.proc + 1))
+        return result
+
+    def write_mesh(self, meshdir):
+        os.makedirs(meshdir, exist_ok=True)
+        points = [(i*self.dx, j*self.dy, k*THICKNESS)
+                  for k in range(2) for j in range(self.ny + 1)
+                  for i in range(self.i0, self.i1 + 1)]
+        # internal faces in upper triangular order: by owner, then neighbour
+        faces, owner, neighbour = [], [], []
+        for j in range(self.ny):
+            for i in range(self.i0, self.i1):
+                c = self.cell(i, j)
+                if i + 1 < self.i1:
+                    faces.append(self.xface(i + 1, j, True))
+                    owner.append(c)
+                    neighbour.append(self.cell(i + 1, j))
+                if j + 1 < self.ny:
+                    faces.append(self.yface(i, j + 1, True))
+                    owner.append(c)
+                    neighbour.append(self.cell(i, j + 1))
+        patches = self.patches()
+        boundary = []
+        for name, ptype, pfaces, nbr in patches:
+            boundary.append((name, ptype, len(pfaces), len(faces), nbr))
+            for face, c in pfaces:
+                faces.append(face)
+                owner.append(c)
+        ncells = self.ni*self.ny
+        note = "nPoints:%d nCells:%d nFaces:%d nInternalFaces:%d" % (
+            len(points), ncells, len(faces), len(neighbour))
+        with open(os.path.join(meshdir, "points"), "w") as f:
+            f.write(header("vectorField", "points", "constant/polyMesh"))
+            write_list(f, points, lambda pt: "(%.10g %.10g %.10g)" % pt)
+        with open(os.path.join(meshdir, "faces"), "w") as f:
+            f.write(header("faceList", "faces", "constant/polyMesh"))
+            write_list(f, faces, lambda fc: "4(%d %d %d %d)" % fc)
+        for name, ids in (("owner", owner), ("neighbour", neighbour)):
+            with open(os.path.join(meshdir, name), "w") as f:
+                f.write(header("labelList", name, "constant/polyMesh")
+                        .replace("    object", '    note        "%s";\n    object' % note))
+                write_list(f, ids, str)
+        with open(os.path.join(meshdir, "boundary"), "w") as f:
+            f.write(header("polyBoundaryMesh", "boundary", "constant/polyMesh"))
+            f.write("%d\n(\n" % len(boundary))
+            for name, ptype, nfaces, start, nbr in boundary:
+                f.write("    %s\n    {\n        type            %s;\n" % (name, ptype))
+                if ptype == "wall":
+                    f.write("        inGroups        List<word> 1(wall);\n")
+                f.write("        nFaces          %d;\n        startFace       %d;\n"
+                        % (nfaces, start))
+                if nbr is not None:
+                    f.write("        matchTolerance  0.0001;\n"
+                            "        myProcNo        %d;\n        neighbProcNo    %d;\n"
+                            % (self.proc, nbr))
+                f.write("    }\n")
+            f.write(")\n")
+
+    def fields(self, t):
+        """cell values of alpha.water and p_rgh at time t"""
+        alpha, prgh = [], []
+        nsub = 8
+        for j in range(self.ny):
+            y0 = j*self.dy
+            for i in range(self.i0, self.i1):
+                # exact fraction below the surface, integrated over the column
+                # width with the midpoint rule
+                frac = 0.0
+                for s in range(nsub):
+                    h = eta((i + (s + 0.5)/nsub)*self.dx, t)
+                    frac += min(max((h - y0)/self.dy, 0.0), 1.0)
+                alpha.append(frac/nsub)
+                prgh.append(RHOG*eta(self.cell_centre(i, j)[0], t))
+        return alpha, prgh
+
+    def write_fields(self, timedir, t, tname):
+        os.makedirs(timedir, exist_ok=True)
+        alpha, prgh = self.fields(t)
+        patches = self.patches()
+        for name, dims, values in (("alpha.water", "[0 0 0 0 0 0 0]", alpha),
+                                   ("p_rgh", "[1 -1 -2 0 0 0 0]", prgh)):
+            with open(os.path.join(timedir, name), "w") as f:
+                f.write(header("volScalarField", name, tname))
+                f.write("dimensions      %s;\n\n" % dims)
+                f.write("internalField   nonuniform List<scalar> ")
+                write_list(f, values, lambda v: "%.10g" % v)
+                f.write(";\n\nboundaryField\n{\n")
+                for pname, ptype, pfaces, nbr in patches:
+                    f.write("    %s\n    {\n" % pname)
+                    if ptype == "empty":
+                        f.write("        type            empty;\n")
+                    elif ptype == "processor":
+                        f.write("        type            processor;\n"
+                                "        value           nonuniform List<scalar> ")
+                        write_list(f, [values[c] for face, c in pfaces],
+                                   lambda v: "%.10g" % v)
+                        f.write(";\n")
+                    else:
+                        f.write("        type            zeroGradient;\n")
+                    f.write("    }\n")
+                f.write("}\n")
+
+
+def time_name(t):
+    return "%.10g" % t
+
+
+def write_control_dict(casedir, dt, end):
+    os.makedirs(os.path.join(casedir, "system"), exist_ok=True)
+    with open(os.path.join(casedir, "system", "controlDict"), "w") as f:
+        f.write(header("dictionary", "controlDict", "system"))
+        f.write("application     interFoam;\nstartFrom       startTime;\n"
+                "startTime       0;\nstopAt          endTime;\n"
+                "endTime         %s;\ndeltaT          %s;\n"
+                "writeControl    adjustableRunTime;\nwriteInterval   %s;\n"
+                "writeFormat     ascii;\nwritePrecision  10;\n"
+                "timeFormat      general;\ntimePrecision   10;\n"
+                % (time_name(end), time_name(dt), time_name(dt)))
+
+
+def generate(casedir, nx, ny, layout, nprocs, ntimes, dt):
+    """write the case and return the path of its .foam file"""
+    os.makedirs(casedir, exist_ok=True)
+    times = [k*dt for k in range(ntimes + 1)]
+    write_control_dict(casedir, dt, times[-1])
+    os.makedirs(os.path.join(casedir, "constant"), exist_ok=True)
+    if layout == "reconstructed":
+        strips = [(casedir, Strip(nx, ny, 0, nx, None, 1))]
+    else:
+        bounds = [p*nx//nprocs for p in range(nprocs + 1)]
+        strips = [(os.path.join(casedir, "processor%d" % p),
+                   Strip(nx, ny, bounds[p], bounds[p + 1], p, nprocs))
+                  for p in range(nprocs)]
+    for root, strip in strips:
+        strip.write_mesh(os.path.join(root, "constant", "polyMesh"))
+        for t in times:
+            strip.write_fields(os.path.join(root, time_name(t)), t, time_name(t))
+    foam = os.path.join(casedir, "case.foam")
+    open(foam, "w").close()
+    return foam
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("casedir")
+    parser.add_argument("--nx", type=int, default=100)
+    parser.add_argument("--ny", type=int, default=40)
+    parser.add_argument("--layout", choices=["reconstructed", "decomposed"],
+                        default="reconstructed")
+    parser.add_argument("--nprocs", type=int, default=4)
+    parser.add_argument("--times", type=int, default=4,
+                        help="number of written time steps after 0")
+    parser.add_argument("--dt", type=float, default=1.0)
+    args = parser.parse_args()
+    if args.layout == "decomposed" and not 1 <= args.nprocs <= args.nx:
+        parser.error("nprocs must be between 1 and nx")
+    print(generate(args.casedir, args.nx, args.ny, args.layout, args.nprocs,
+                   args.times, args.dt))
+
+
+if __name__ == "__main__":
+    main()
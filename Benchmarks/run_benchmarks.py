@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+"""Time ExtractAtInterface and GridConvergence on synthetic cases.
+
+Cases are written by generate_case.py into the work directory (and reused on
+later runs) in reconstructed and decomposed layouts at each mesh size. Each
+tool is run with a "Report" file, the extracted interface is compared with
+the analytic one and a summary of all runs is written to
+<work>/benchmark_summary.json. ExtractAtInterface is run with and without a
+"Narrow Band" block. Exits with status 1 if a run fails, an interface is
+further than --tolerance cell heights from the analytic one or a narrow band
+interface is further than --band-tolerance cell heights from the default one.
+"""
+import argparse
+import glob
+import json
+import os
+import subprocess
+import sys
+import time
+
+import generate_case
+
+LAYOUTS = ("reconstructed", "decomposed")
+
+
+def parse_sizes(text):
+    sizes = []
+    for item in text.split(","):
+        nx, ny = item.lower().split("x")
+        sizes.append((int(nx), int(ny)))
+    return sizes
+
+
+def case_path(work, nx, ny, layout, args):
+    """generate the case unless an identical one is already in work"""
+    casedir = os.path.join(work, "cases", "%dx%d_%s" % (nx, ny, layout))
+    params = {"nx": nx, "ny": ny, "layout": layout, "nprocs": args.nprocs,
+              "times": args.times, "dt": args.dt}
+    stamp = os.path.join(casedir, "generated.json")
+    foam = os.path.join(casedir, "case.foam")
+    if os.path.exists(stamp):
+        with open(stamp) as f:
+            if json.load(f) == params:
+                return foam
+    print("Generating %s" % casedir, flush=True)
+    generate_case.generate(casedir, nx, ny, layout, args.nprocs, args.times, args.dt)
+    with open(stamp, "w") as f:
+        json.dump(params, f)
+    return foam
+
+
+def run_tool(exe, rundir, inp):
+    """run exe on input inp in rundir, return (exit status, seconds, report)"""
+    os.makedirs(rundir, exist_ok=True)
+    for old in glob.glob(os.path.join(rundir, "*")):
+        os.remove(old)
+    with open(os.path.join(rundir, "input.json"), "w") as f:
+        json.dump(inp, f, indent=2)
+    start = time.time()
+    with open(os.path.join(rundir, "log.txt"), "w") as log:
+        status = subprocess.call([exe, "input.json"], cwd=rundir, stdout=log,
+                                 stderr=subprocess.STDOUT)
+    seconds = time.time() - start
+    report = None
+    if os.path.exists(os.path.join(rundir, "report.json")):
+        with open(os.path.join(rundir, "report.json")) as f:
+            report = json.load(f)
+    return status, seconds, report
+
+
+def read_frame(rundir, k):
+    """(x, height) rows of frame k, None if missing or empty"""
+    fname = os.path.join(rundir, "OpenFoamframeNo%05d.txt" % (k + 1))
+    if not os.path.exists(fname):
+        return None
+    with open(fname) as f:
+        rows = [tuple(float(v) for v in line.split()[:2]) for line in f if line.strip()]
+    return rows or None
+
+
+def interface_error(rundir, args):
+    """largest distance between the written contours and the analytic
+    interface, None if a frame is missing"""
+    worst = 0.0
+    for k in range(args.times + 1):
+        rows = read_frame(rundir, k)
+        if rows is None:
+            return None
+        t = k*args.dt
+        for x, h in rows:
+            worst = max(worst, abs(h - generate_case.eta(x, t)))
+    return worst
+
+
+def interpolate(rows, x):
+    """linear interpolation of the sorted rows at x, None outside them"""
+    lo, hi = 0, len(rows) - 1
+    if not rows[lo][0] <= x <= rows[hi][0]:
+        return None
+    while hi - lo > 1:
+        mid = (lo + hi)//2
+        if rows[mid][0] <= x:
+            lo = mid
+        else:
+            hi = mid
+    (x0, h0), (x1, h1) = rows[lo], rows[hi]
+    if x1 == x0:
+        return h0
+    return h0 + (h1 - h0)*(x - x0)/(x1 - x0)
+
+
+def interface_difference(rundir, refdir, args):
+    """largest height difference between the contours of rundir and those of
+    refdir at the same x, None if a frame is missing"""
+    worst = 0.0
+    for k in range(args.times + 1):
+        rows, ref = read_frame(rundir, k), read_frame(refdir, k)
+        if rows is None or ref is None:
+            return None
+        for x, h in rows:
+            href = interpolate(ref, x)
+            if href is not None:
+                worst = max(worst, abs(h - href))
+    return worst
+
+
+def times_block(args):
+    return {"start": 0, "stride": args.dt, "end": args.times*args.dt}
+
+
+def bench_extract(exe, work, args, results):
+    for nx, ny in args.sizes:
+        for layout in LAYOUTS:
+            foam = case_path(work, nx, ny, layout, args)
+            name = "%dx%d_%s" % (nx, ny, layout)
+            dy = generate_case.DEPTH/ny
+            # the default path runs first, the narrow band is compared with it
+            refdir = None
+            for mode in ("default", "narrow band"):
+                rundir = os.path.join(work, "extract",
+                                      name if mode == "default" else name + "_band")
+                inp = {"Case Name": os.path.abspath(foam), "Case Type": layout,
+                       "Dimension": 2, "Times": times_block(args),
+                       "Contour": {"array": "alpha.water", "value": 0.5,
+                                   "data": {"name": "p_rgh"}},
+                       "Write": True, "Smoothing": False,
+                       "Threads": args.threads, "Report": "report.json"}
+                if mode == "narrow band":
+                    inp["Narrow Band"] = {}
+                status, seconds, report = run_tool(exe, rundir, inp)
+                error = interface_error(rundir, args) if status == 0 else None
+                passed = error is not None and error <= args.tolerance*dy
+                result = {"tool": "ExtractAtInterface", "mesh": "%dx%d" % (nx, ny),
+                          "layout": layout, "mode": mode, "status": status,
+                          "seconds": seconds, "max error": error, "cell height": dy}
+                diff = None
+                if refdir is not None:
+                    if status == 0:
+                        diff = interface_difference(rundir, refdir, args)
+                    passed = passed and diff is not None and diff <= args.band_tolerance*dy
+                    result["max difference from default"] = diff
+                result["passed"] = passed
+                result["report"] = report
+                results.append(result)
+                print("ExtractAtInterface %5dx%-4d %-13s %-11s %8.2fs  error %s%s  %s"
+                      % (nx, ny, layout, mode, seconds,
+                         "-" if error is None else "%.3g" % error,
+                         "" if refdir is None else "  difference %s"
+                         % ("-" if diff is None else "%.3g" % diff),
+                         "ok" if passed else "FAILED"), flush=True)
+                refdir = rundir
+
+
+def bench_grid(exe, work, args, results):
+    if len(args.sizes) < 3:
+        print("GridConvergence needs at least 3 mesh sizes, skipped")
+        return
+    # three finest meshes as coarse, medium and fine
+    grids = args.sizes[-3:]
+    for layout in LAYOUTS:
+        names = [os.path.abspath(case_path(work, nx, ny, layout, args))
+                 for nx, ny in grids]
+        rundir = os.path.join(work, "grid", layout)
+        ratio = [grids[i + 1][0]/grids[i][0] for i in range(2)]
+        inp = {"Coarse Case": {"Name": names[0], "Type": layout},
+               "Medium Case": {"Name": names[1], "Type": layout,
+                               "Refinement Ratio": ratio[0]},
+               "Fine Case": {"Name": names[2], "Type": layout,
+                             "Refinement Ratio": ratio[1]},
+               "Times": times_block(args),
+               "Contour": {"array": "alpha.water", "value": 0.5},
+               "Data": ["p_rgh"],
+               "Plot": {"title": "benchmark", "width": 1200, "height": 800},
+               "Threads": args.threads, "Report": "report.json"}
+        status, seconds, report = run_tool(exe, rundir, inp)
+        nfigs = len(glob.glob(os.path.join(rundir, "figFrame*.png")))
+        passed = status == 0 and nfigs == args.times + 1
+        results.append({"tool": "GridConvergence",
+                        "mesh": ",".join("%dx%d" % g for g in grids),
+                        "layout": layout, "status": status, "seconds": seconds,
+                        "passed": passed, "report": report})
+        print("GridConvergence    %-10s %-13s %8.2fs  %s"
+              % ("x".join(str(g[0]) for g in grids), layout, seconds,
+                 "ok" if passed else "FAILED"), flush=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--extract", help="ExtractAtInterface executable")
+    parser.add_argument("--grid", help="GridConvergence executable")
+    parser.add_argument("--work", default="benchmark", help="work directory")
+    parser.add_argument("--sizes", type=parse_sizes, default="100x40,200x80,400x160",
+                        help="comma separated mesh sizes, e.g. 100x40,200x80")
+    parser.add_argument("--nprocs", type=int, default=4,
+                        help="processors of the decomposed cases")
+    parser.add_argument("--times", type=int, default=4,
+                        help="written time steps after 0")
+    parser.add_argument("--dt", type=float, default=1.0)
+    parser.add_argument("--threads", type=int, default=1)
+    parser.add_argument("--tolerance", type=float, default=1.0,
+                        help="allowed interface error in cell heights")
+    parser.add_argument("--band-tolerance", type=float, default=0.5,
+                        help="allowed difference between the narrow band and the "
+                             "default interface in cell heights")
+    args = parser.parse_args()
+    if not args.extract and not args.grid:
+        parser.error("give --extract and/or --grid")
+    work = os.path.abspath(args.work)
+    results = []
+    if args.extract:
+        bench_extract(os.path.abspath(args.extract), work, args, results)
+    if args.grid:
+        bench_grid(os.path.abspath(args.grid), work, args, results)
+    summary = os.path.join(work, "benchmark_summary.json")
+    with open(summary, "w") as f:
+        json.dump(results, f, indent=2)
+    print("Summary written to %s" % summary)
+    sys.exit(0 if all(r["passed"] for r in results) else 1)
+
+
+if __name__ == "__main__":
+    main()